@@ -0,0 +1,364 @@
+//Header with the offline Batch Renderer (renders image sequences without opening a window)
+#pragma once
+
+//Camera pose, the camera sits at position and looks at target
+struct cameraPose {
+	vector3D position;
+	vector3D target;
+};
+
+//More threads or a bigger image than this is treated as a mistake on the command line
+const long MAX_BATCH_THREADS = 1024;
+const long MAX_BATCH_IMAGE_SIZE = 16384;
+//Models are loaded, rendered and released in groups of this many, which bounds the memory used
+//by thousands of models while still giving every thread a model to work on
+const int BATCH_MODEL_GROUP_SIZE = 64;
+
+//Settings read from the command line
+struct batchSettings {
+	std::vector<std::string> models;
+	std::vector<std::string> names; //unique name of every model, used for its output images
+	std::string sPoseFile;
+	int iOrbitViews = 0;
+	float fOrbitRadius = 0.0f; //0 picks a radius from the size of the model
+	float fOrbitElevation = 0.0f; //degrees
+	int iWidth = 800;
+	int iHeight = 600;
+	std::string sOutput = ".";
+	unsigned int nThreads = 0; //0 uses every core
+};
+
+//A single image to render: which model and from which pose
+struct batchJob {
+	int iModel;
+	int iPose;
+};
+
+void PrintBatchUsage() {
+	std::cout << "Usage: 3DRenderEngine --batch --model <file.obj> [--model <file.obj> ...]\n"
+		<< "                      (--orbit <views> <radius> <elevation> | --poses <file>)\n"
+		<< "                      [--size <width>x<height>] [--out <directory>] [--threads <n>]\n"
+		<< "  --orbit  render <views> images evenly spaced around the model, radius 0 fits the model\n"
+		<< "  --orbit  elevation has to lie between -90 and 90 degrees (exclusive)\n"
+		<< "  --poses  text file with one pose per line: px py pz tx ty tz (camera position, target)\n"
+		<< "  --threads 0 uses every core\n";
+}
+
+//Read a whole argument as an integer, trailing characters make it invalid
+bool ParseLong(const char* sArg, long& value) {
+	char* end;
+	errno = 0;
+	value = strtol(sArg, &end, 10);
+	return *sArg != '\0' && *end == '\0' && errno == 0;
+}
+
+//Read a whole argument as a finite float, trailing characters make it invalid
+bool ParseFloat(const char* sArg, float& value) {
+	char* end;
+	errno = 0;
+	value = strtof(sArg, &end);
+	return *sArg != '\0' && *end == '\0' && errno == 0 && std::isfinite(value);
+}
+
+//Read a size written as <width>x<height>
+bool ParseSize(const char* sArg, int& iWidth, int& iHeight) {
+	std::string sSize = sArg;
+	size_t iX = sSize.find('x');
+	long nWidth, nHeight;
+	if (iX == std::string::npos || !ParseLong(sSize.substr(0, iX).c_str(), nWidth) || !ParseLong(sSize.substr(iX + 1).c_str(), nHeight))
+		return false;
+	if (nWidth <= 0 || nHeight <= 0 || nWidth > MAX_BATCH_IMAGE_SIZE || nHeight > MAX_BATCH_IMAGE_SIZE)
+		return false;
+	iWidth = (int)nWidth;
+	iHeight = (int)nHeight;
+	return true;
+}
+
+//Read the command line, returns false if it is not valid
+bool ParseBatchArguments(int argc, char* argv[], batchSettings& settings) {
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		int nLeft = argc - i - 1; //how many values follow the current argument
+		if (arg == "--batch") {
+			continue;
+		}
+		else if (arg == "--model" && nLeft >= 1) {
+			settings.models.push_back(argv[++i]);
+		}
+		else if (arg == "--poses" && nLeft >= 1) {
+			settings.sPoseFile = argv[++i];
+		}
+		else if (arg == "--orbit" && nLeft >= 3) {
+			long nViews;
+			if (!ParseLong(argv[i + 1], nViews) || nViews <= 0 || nViews > 9999) {
+				std::cerr << "--orbit views has to be a number from 1 to 9999\n";
+				return false;
+			}
+			if (!ParseFloat(argv[i + 2], settings.fOrbitRadius) || settings.fOrbitRadius < 0.0f) {
+				std::cerr << "--orbit radius has to be a number >= 0 (0 fits the model)\n";
+				return false;
+			}
+			//At +-90 degrees the camera looks straight along the up axis and the view is undefined
+			if (!ParseFloat(argv[i + 3], settings.fOrbitElevation) || !(fabsf(settings.fOrbitElevation) < 90.0f)) {
+				std::cerr << "--orbit elevation has to be a number between -90 and 90 degrees\n";
+				return false;
+			}
+			settings.iOrbitViews = (int)nViews;
+			i += 3;
+		}
+		else if (arg == "--size" && nLeft >= 1) {
+			if (!ParseSize(argv[++i], settings.iWidth, settings.iHeight)) {
+				std::cerr << "--size has to be <width>x<height>, each from 1 to " << MAX_BATCH_IMAGE_SIZE << "\n";
+				return false;
+			}
+		}
+		else if (arg == "--out" && nLeft >= 1) {
+			settings.sOutput = argv[++i];
+		}
+		else if (arg == "--threads" && nLeft >= 1) {
+			long nThreads;
+			if (!ParseLong(argv[++i], nThreads) || nThreads < 0 || nThreads > MAX_BATCH_THREADS) {
+				std::cerr << "--threads has to be a number from 0 to " << MAX_BATCH_THREADS << "\n";
+				return false;
+			}
+			settings.nThreads = (unsigned int)nThreads;
+		}
+		else {
+			std::cerr << "Unknown or incomplete argument: " << arg << "\n";
+			return false;
+		}
+	}
+	if (settings.models.empty())
+		return false;
+
+	//Output images are named after the model file, models sharing a file name
+	//(e.g. a/model.obj and b/model.obj) get their position on the command line appended
+	std::map<std::string, int> stemCount;
+	for (auto& model : settings.models)
+		stemCount[std::filesystem::path(model).stem().string()]++;
+	std::set<std::string> names;
+	for (int m = 0; m < (int)settings.models.size(); m++) {
+		std::string sName = std::filesystem::path(settings.models[m]).stem().string();
+		if (stemCount[sName] > 1)
+			sName += "_" + std::to_string(m);
+		if (!names.insert(sName).second) {
+			std::cerr << "Two models would write to the same images: " << sName << "\n";
+			return false;
+		}
+		settings.names.push_back(sName);
+	}
+
+	//Exactly one source of camera poses
+	return (settings.iOrbitViews > 0) != !settings.sPoseFile.empty();
+}
+
+//Read camera poses from a text file, blank lines and lines starting with '#' are skipped
+//Any other line that is not a valid pose fails the whole file, so frame numbers never shift
+bool LoadPoseFile(std::string sFilename, std::vector<cameraPose>& poses) {
+	std::ifstream f(sFilename);
+	if (!f.is_open()) {
+		return false;
+	}
+	std::string line;
+	int iLine = 0;
+	while (std::getline(f, line)) {
+		iLine++;
+		size_t iFirst = line.find_first_not_of(" \t\r");
+		if (iFirst == std::string::npos || line[iFirst] == '#')
+			continue;
+		std::istringstream s(line);
+		cameraPose pose;
+		if (!(s >> pose.position.x >> pose.position.y >> pose.position.z >> pose.target.x >> pose.target.y >> pose.target.z) || !(s >> std::ws).eof()) {
+			std::cerr << sFilename << ":" << iLine << ": expected \"px py pz tx ty tz\"\n";
+			return false;
+		}
+		if (pose.position.x == pose.target.x && pose.position.y == pose.target.y && pose.position.z == pose.target.z) {
+			std::cerr << sFilename << ":" << iLine << ": camera position and target are the same point\n";
+			return false;
+		}
+		poses.push_back(pose);
+	}
+	return !poses.empty();
+}
+
+//Camera poses evenly spaced on a circle around the centre of the model
+//fAspectRatio is height / width of the image, as passed to mProject
+std::vector<cameraPose> OrbitPoses(const mesh& meshObj, int iViews, float fRadius, float fElevationDeg, float fAspectRatio) {
+	//Bounding box of the model
+	vector3D vMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+	vector3D vMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (auto& tri : meshObj.tris) {
+		for (int i = 0; i < 3; i++) {
+			vMin.x = std::min(vMin.x, tri.p[i].x); vMax.x = std::max(vMax.x, tri.p[i].x);
+			vMin.y = std::min(vMin.y, tri.p[i].y); vMax.y = std::max(vMax.y, tri.p[i].y);
+			vMin.z = std::min(vMin.z, tri.p[i].z); vMax.z = std::max(vMax.z, tri.p[i].z);
+		}
+	}
+	vector3D vCentre = (vMin + vMax) * 0.5f;
+	vector3D vHalfSize = (vMax - vMin) * 0.5f;
+
+	//The vertical field of view is 90 degrees, there the bounding sphere fits in view from sqrt(2) times its radius
+	//In portrait images the horizontal field of view is narrower by width / height, so move back by height / width
+	if (fRadius <= 0.0f)
+		fRadius = std::max(1.5f * vHalfSize.vLength() * std::max(1.0f, fAspectRatio), 0.2f);
+
+	float fElevation = fElevationDeg / 180.0f * 3.14159f;
+	std::vector<cameraPose> poses;
+	for (int i = 0; i < iViews; i++) {
+		float fAngle = 2.0f * 3.14159f * i / iViews;
+		cameraPose pose;
+		pose.position.x = vCentre.x + fRadius * cosf(fElevation) * sinf(fAngle);
+		pose.position.y = vCentre.y + fRadius * sinf(fElevation);
+		pose.position.z = vCentre.z - fRadius * cosf(fElevation) * cosf(fAngle);
+		pose.target = vCentre;
+		poses.push_back(pose);
+	}
+	return poses;
+}
+
+//Render one image of the model into the frame buffer
+void RenderFrame(const mesh& meshObj, cameraPose& pose, mat4x4& matProj, frameBuffer& fb) {
+	//clean frame
+	fb.Clear(PackColour(255, 255, 255, 255));
+
+	//Model is rendered where it is, the camera moves around it
+	mat4x4 matWorld;
+	matWorld = matWorld.mIdentity();
+
+	//Looking straight up or down the Y axis leaves no sideways direction, so use Z as up instead
+	vector3D vUp = { 0, 1, 0 };
+	vector3D vDirection = pose.target - pose.position;
+	if (fabsf(vDirection.y) > 0.9999f * vDirection.vLength())
+		vUp = { 0, 0, 1 };
+	mat4x4 matCamera = matCamera.mPointAt(pose.position, pose.target, vUp);
+	mat4x4 matView = matView.mQuickInverse(matCamera);
+
+	std::vector<triangle> vecTrianglesToRaster = ProjectMesh(meshObj, matWorld, matView, matProj, pose.position, (float)fb.iWidth, (float)fb.iHeight);
+	DrawTriangles(fb, vecTrianglesToRaster);
+}
+
+//Name of an output image, e.g. out/teapot_0007.png
+std::string FrameFilename(batchSettings& settings, int iModel, int iPose) {
+	char sFrame[16];
+	snprintf(sFrame, sizeof(sFrame), "_%04d.png", iPose);
+	return (std::filesystem::path(settings.sOutput) / (settings.names[iModel] + sFrame)).string();
+}
+
+//Entry point of the batch mode
+//Every model is loaded once and shared read-only by all threads, each thread takes whole frames
+//Returns non-zero if any model could not be loaded or any frame could not be written
+int RunBatch(int argc, char* argv[]) {
+	batchSettings settings;
+	if (!ParseBatchArguments(argc, argv, settings)) {
+		PrintBatchUsage();
+		return 1;
+	}
+
+	std::vector<cameraPose> filePoses;
+	if (!settings.sPoseFile.empty() && !LoadPoseFile(settings.sPoseFile, filePoses)) {
+		std::cerr << "Could not read poses from " << settings.sPoseFile << "\n";
+		return 1;
+	}
+
+	//Fail early if the images can not be written
+	std::error_code error;
+	std::filesystem::create_directories(settings.sOutput, error);
+	if (error || !std::filesystem::is_directory(settings.sOutput, error)) {
+		std::cerr << "Could not create output directory " << settings.sOutput << ": " << (error ? error.message() : "not a directory") << "\n";
+		return 1;
+	}
+
+	unsigned int nThreads = settings.nThreads;
+	if (nThreads == 0)
+		nThreads = std::max(1u, std::thread::hardware_concurrency());
+
+	//Projection Matrix is the same for every frame
+	mat4x4 matProj;
+	matProj = matProj.mProject(90.0f, (float)settings.iHeight / (float)settings.iWidth, 0.1f, 1000.0f);
+
+	sf::Clock clock;
+	float fRenderTime = 0.0f;
+	size_t nFrames = 0;
+	std::atomic<size_t> nWritten(0);
+	int nNotLoaded = 0;
+	std::mutex errorMutex;
+
+	//Every group of models is loaded, rendered and released before the next one is loaded
+	for (int iFirst = 0; iFirst < (int)settings.models.size(); iFirst += BATCH_MODEL_GROUP_SIZE) {
+		int nModels = std::min(BATCH_MODEL_GROUP_SIZE, (int)settings.models.size() - iFirst);
+
+		//Load the models of the group, they are independent so the loading is spread over the threads as well
+		std::vector<mesh> meshes(nModels);
+		std::vector<char> loaded(nModels, 0);
+		std::atomic<int> nextModel(0);
+		auto loadModels = [&]() {
+			for (int i = nextModel++; i < nModels; i = nextModel++)
+				loaded[i] = meshes[i].LoadFromObjectFile(settings.models[iFirst + i]);
+		};
+		std::vector<std::thread> threads;
+		for (unsigned int n = 0; n < std::min(nThreads, (unsigned int)nModels); n++)
+			threads.emplace_back(loadModels);
+		for (auto& thread : threads)
+			thread.join();
+		threads.clear();
+
+		//Build the list of frames
+		std::vector<std::vector<cameraPose>> poses(nModels);
+		std::vector<batchJob> jobs;
+		for (int m = 0; m < nModels; m++) {
+			if (!loaded[m] || meshes[m].tris.empty()) {
+				std::cerr << "Could not load " << settings.models[iFirst + m] << "\n";
+				nNotLoaded++;
+				continue;
+			}
+			poses[m] = filePoses.empty() ? OrbitPoses(meshes[m], settings.iOrbitViews, settings.fOrbitRadius, settings.fOrbitElevation, (float)settings.iHeight / (float)settings.iWidth) : filePoses;
+			for (int p = 0; p < (int)poses[m].size(); p++)
+				jobs.push_back({ m, p });
+		}
+		nFrames += jobs.size();
+
+		//Render the frames, every thread owns its frame buffer and image
+		std::atomic<size_t> nextJob(0);
+		auto renderFrames = [&]() {
+			frameBuffer fb;
+			fb.Resize(settings.iWidth, settings.iHeight);
+			mat4x4 matThreadProj = matProj;
+			sf::Image image;
+			for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+				batchJob& job = jobs[i];
+				cameraPose pose = poses[job.iModel][job.iPose];
+				RenderFrame(meshes[job.iModel], pose, matThreadProj, fb);
+				image.create(settings.iWidth, settings.iHeight, (const sf::Uint8*)fb.colour.data());
+				std::string sFilename = FrameFilename(settings, iFirst + job.iModel, job.iPose);
+				if (image.saveToFile(sFilename)) {
+					nWritten++;
+				}
+				else {
+					std::lock_guard<std::mutex> lock(errorMutex);
+					std::cerr << "Could not write " << sFilename << "\n";
+				}
+			}
+		};
+		sf::Clock renderClock;
+		for (unsigned int n = 0; n < std::min((size_t)nThreads, jobs.size()); n++)
+			threads.emplace_back(renderFrames);
+		for (auto& thread : threads)
+			thread.join();
+		fRenderTime += renderClock.getElapsedTime().asSeconds();
+	}
+	float fTotalTime = clock.getElapsedTime().asSeconds();
+
+	//Report throughput of the frames that were written, only threads that had a frame and a core
+	//to run on count as busy cores
+	unsigned int nCores = std::max(1u, std::thread::hardware_concurrency());
+	size_t nBusyCores = std::max((size_t)1, std::min({ (size_t)nThreads, nFrames, (size_t)nCores }));
+	float fFps = fRenderTime > 0.0f ? nWritten / fRenderTime : 0.0f;
+	std::cout << "Rendered " << nWritten << " of " << nFrames << " frames at "
+		<< settings.iWidth << "x" << settings.iHeight << " on " << nThreads << " threads (" << nBusyCores << " cores busy)\n";
+	if (nNotLoaded > 0)
+		std::cout << "Skipped " << nNotLoaded << " of " << settings.models.size() << " models that could not be loaded\n";
+	std::cout << "Render time " << fRenderTime << " s (total " << fTotalTime << " s including loading)\n"
+		<< "Throughput " << fFps << " frames/s, " << fFps / nBusyCores << " frames/s per core\n";
+
+	return (nNotLoaded > 0 || nWritten != nFrames || nFrames == 0) ? 1 : 0;
+}
@@ -0,0 +1,114 @@
+//Fill-rate benchmark of the Triangle Rasterizer
+//Build: g++ -O2 -mavx2 FillRateBenchmark.cpp -o FillRateBenchmark (leave out -mavx2 to measure the scalar path)
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <map>
+#include "Rasterizer.h"
+
+//Triangle shape that is drawn many times at different positions
+struct benchmarkCase {
+	std::string sName;
+	float fWidth; //size of the triangle in pixels
+	float fHeight;
+};
+
+int main()
+{
+	const int iScreenWidth = 1920;
+	const int iScreenHeight = 1080;
+	frameBuffer fb;
+	fb.Resize(iScreenWidth, iScreenHeight);
+
+	std::vector<benchmarkCase> cases = {
+		{ "sliver 1000x1", 1000.0f, 1.0f },
+		{ "sliver 1x1000", 1.0f, 1000.0f },
+		{ "tiny 4x4", 4.0f, 4.0f },
+		{ "small 16x16", 16.0f, 16.0f },
+		{ "medium 64x64", 64.0f, 64.0f },
+		{ "large 256x256", 256.0f, 256.0f },
+		{ "huge 1024x1024", 1024.0f, 1024.0f },
+		{ "full screen", 2.0f * iScreenWidth, 2.0f * iScreenHeight },
+	};
+
+#if defined(__AVX2__)
+	std::cout << "Rasterizer path: AVX2\n";
+#else
+	std::cout << "Rasterizer path: scalar\n";
+#endif
+	std::cout << std::left << std::setw(18) << "triangle" << std::right << std::setw(14) << "pixels/tri" << std::setw(14) << "Ktris/s" << std::setw(14) << "Mpixels/s" << "\n";
+
+	for (auto& c : cases) {
+		//Right triangle, the full screen one covers the whole screen with its hypotenuse off screen
+		auto draw = [&](float x, float y, float z) {
+			rasterVertex v0 = { x, y, z };
+			rasterVertex v1 = { x + c.fWidth, y, z };
+			rasterVertex v2 = { x, y + c.fHeight, z };
+			RasterizeTriangle(fb, v0, v1, v2, PackColour(150, 0, 150, 255));
+		};
+		//Positions cycle over the screen (with fractional offsets) so the triangles are not all block aligned
+		float fRangeX = std::max(1.0f, iScreenWidth - c.fWidth);
+		float fRangeY = std::max(1.0f, iScreenHeight - c.fHeight);
+		auto position = [&](int i, float& x, float& y) {
+			x = c.fWidth >= iScreenWidth ? 0.0f : fmodf(i * 37.3f, fRangeX);
+			y = c.fHeight >= iScreenHeight ? 0.0f : fmodf(i * 23.7f, fRangeY);
+		};
+
+		//Count the pixels covered by the triangles of a batch, the positions have fractional offsets
+		//so the coverage differs between them. Only the bounding box of a triangle is counted and reset.
+		//Moving a triangle that is fully on screen by whole pixels does not change its coverage,
+		//so those are counted once per fractional offset (and off screen ones once per position)
+		const int nBatch = 2000;
+		float x, y;
+		long long nCovered = 0;
+		std::map<std::pair<float, float>, long long> coverage;
+		fb.Clear(0);
+		for (int i = 0; i < nBatch; i++) {
+			position(i, x, y);
+			bool bOnScreen = x + c.fWidth < iScreenWidth && y + c.fHeight < iScreenHeight;
+			std::pair<float, float> key = bOnScreen ? std::make_pair(x - floorf(x), y - floorf(y)) : std::make_pair(x, y);
+			auto cached = coverage.find(key);
+			if (cached != coverage.end()) {
+				nCovered += cached->second;
+				continue;
+			}
+			draw(x, y, 0.5f);
+			int iMinX = std::max(0, (int)x), iMaxX = std::min(iScreenWidth - 1, (int)(x + c.fWidth) + 1);
+			int iMinY = std::max(0, (int)y), iMaxY = std::min(iScreenHeight - 1, (int)(y + c.fHeight) + 1);
+			long long nPixels = 0;
+			for (int py = iMinY; py <= iMaxY; py++) {
+				for (int px = iMinX; px <= iMaxX; px++) {
+					float& d = fb.depth[(size_t)py * iScreenWidth + px];
+					if (d != FLT_MAX) {
+						nPixels++;
+						d = FLT_MAX;
+					}
+				}
+			}
+			coverage[key] = nPixels;
+			nCovered += nPixels;
+		}
+
+		//Draw with decreasing depth so every pixel passes the depth test and is written,
+		//the buffers are cleared between batches outside of the timed part
+		long long nTriangles = 0;
+		double fSeconds = 0.0;
+		while (fSeconds < 0.5) {
+			fb.Clear(0);
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < nBatch; i++) {
+				position(i, x, y);
+				draw(x, y, 1.0f - i * (0.5f / nBatch));
+			}
+			fSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			nTriangles += nBatch;
+		}
+
+		std::cout << std::left << std::setw(18) << c.sName << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(14) << (double)nCovered / nBatch
+			<< std::setw(14) << std::setprecision(3) << nTriangles / fSeconds / 1e3 << std::setprecision(1)
+			<< std::setw(14) << nTriangles / nBatch * (double)nCovered / fSeconds / 1e6 << "\n";
+	}
+	return 0;
+}
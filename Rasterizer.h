@@ -0,0 +1,269 @@
+//Header with the Triangle Rasterizer (fixed-point edge functions, 8x8 pixel blocks, depth test)
+//Compile with AVX2 enabled (-mavx2 or /arch:AVX2) to test and fill the blocks 8 lanes at a time
+#pragma once
+#include <cstdint>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+//Vertices are snapped to 1/16 of a pixel
+const int RASTER_SUBPIXEL_BITS = 4;
+const int RASTER_SUBPIXEL_STEP = 1 << RASTER_SUBPIXEL_BITS;
+//Pixels are visited in square blocks of 8x8
+const int RASTER_BLOCK_SIZE = 8;
+//Triangles wider or taller than this (in pixels) are split in two before rasterizing,
+//so that every edge function value within a triangle fits in 32 bits
+const float RASTER_MAX_EXTENT = 2000.0f;
+
+//Screen space vertex, z is the depth that is interpolated and tested
+struct rasterVertex {
+	float x = 0.0f;
+	float y = 0.0f;
+	float z = 0.0f;
+};
+
+//Colour and depth buffer the triangles are drawn into
+//Colours are stored as RGBA bytes, which is the layout sf::Image and sf::Texture expect
+struct frameBuffer {
+	int iWidth = 0;
+	int iHeight = 0;
+	std::vector<uint32_t> colour;
+	std::vector<float> depth;
+	void Resize(int iNewWidth, int iNewHeight);
+	void Clear(uint32_t clr);
+};
+
+//Resize the buffers
+void frameBuffer::Resize(int iNewWidth, int iNewHeight) {
+	iWidth = iNewWidth;
+	iHeight = iNewHeight;
+	colour.assign((size_t)iWidth * iHeight, 0);
+	depth.assign((size_t)iWidth * iHeight, FLT_MAX);
+}
+
+//Fill the colour buffer and reset the depth buffer
+void frameBuffer::Clear(uint32_t clr) {
+	std::fill(colour.begin(), colour.end(), clr);
+	std::fill(depth.begin(), depth.end(), FLT_MAX);
+}
+
+//Pack a colour into the byte order of the frame buffer
+uint32_t PackColour(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+	return (uint32_t)r | ((uint32_t)g << 8) | ((uint32_t)b << 16) | ((uint32_t)a << 24);
+}
+
+//Edge function E(p) = A * (p.x - a.x) + B * (p.y - a.y) of the edge from a to b, in subpixel units
+//Pixels with E >= 0 for all three edges are inside the triangle
+struct rasterEdge {
+	int32_t A;
+	int32_t B;
+	int32_t iOrigin; //value at the centre of the first pixel of the block grid, bias included
+};
+
+//Set up the edge from a to b
+//Top-left fill rule: a pixel centre lying exactly on an edge is only drawn if it is a top or left edge,
+//so pixels on an edge shared by two triangles are drawn exactly once
+rasterEdge SetupEdge(int32_t ax, int32_t ay, int32_t bx, int32_t by) {
+	rasterEdge edge;
+	edge.A = ay - by;
+	edge.B = bx - ax;
+	bool bTopLeft = edge.A > 0 || (edge.A == 0 && edge.B > 0);
+	int32_t iCentre = RASTER_SUBPIXEL_STEP / 2;
+	edge.iOrigin = edge.A * (iCentre - ax) + edge.B * (iCentre - ay) + (bTopLeft ? 0 : -1);
+	return edge;
+}
+
+//Draw the pixels of the 8x8 block at (x, y) that are covered, in front of the depth buffer and on the screen
+//e and fZ are the edge functions and the depth at the first pixel centre of the block
+//bFullyCovered skips the edge functions when the whole block is known to be inside the triangle
+void RasterizeBlock(frameBuffer& fb, int x, int y, rasterEdge* edges, int32_t* e, bool bFullyCovered, float fZ, float fDzDx, float fDzDy, uint32_t clr) {
+	int nRows = std::min(RASTER_BLOCK_SIZE, fb.iHeight - y);
+	int nColumns = std::min(RASTER_BLOCK_SIZE, fb.iWidth - x);
+	float* pDepth = &fb.depth[(size_t)y * fb.iWidth + x];
+	uint32_t* pColour = &fb.colour[(size_t)y * fb.iWidth + x];
+
+#if defined(__AVX2__)
+	const __m256i vLane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	const __m256 vLaneF = _mm256_cvtepi32_ps(vLane);
+	//Lanes past the right side of the screen are never loaded or stored
+	const __m256i vOnScreen = _mm256_cmpgt_epi32(_mm256_set1_epi32(nColumns), vLane);
+	const __m256i vColour = _mm256_set1_epi32((int)clr);
+	__m256i vE[3], vStepY[3];
+	for (int i = 0; i < 3; i++) {
+		vE[i] = _mm256_add_epi32(_mm256_set1_epi32(e[i]), _mm256_mullo_epi32(_mm256_set1_epi32(edges[i].A * RASTER_SUBPIXEL_STEP), vLane));
+		vStepY[i] = _mm256_set1_epi32(edges[i].B * RASTER_SUBPIXEL_STEP);
+	}
+	__m256 vZ = _mm256_add_ps(_mm256_set1_ps(fZ), _mm256_mul_ps(_mm256_set1_ps(fDzDx), vLaneF));
+	const __m256 vDzDy = _mm256_set1_ps(fDzDy);
+
+	for (int row = 0; row < nRows; row++) {
+		__m256i vMask = vOnScreen;
+		if (!bFullyCovered) {
+			//Sign bit of the OR is clear only where all three edge functions are >= 0
+			__m256i vOutside = _mm256_or_si256(_mm256_or_si256(vE[0], vE[1]), vE[2]);
+			vMask = _mm256_andnot_si256(_mm256_srai_epi32(vOutside, 31), vMask);
+			for (int i = 0; i < 3; i++)
+				vE[i] = _mm256_add_epi32(vE[i], vStepY[i]);
+		}
+		if (!_mm256_testz_si256(vMask, vMask)) {
+			__m256 vDepth = _mm256_maskload_ps(pDepth, vMask);
+			vMask = _mm256_and_si256(vMask, _mm256_castps_si256(_mm256_cmp_ps(vZ, vDepth, _CMP_LT_OQ)));
+			_mm256_maskstore_ps(pDepth, vMask, vZ);
+			_mm256_maskstore_epi32((int*)pColour, vMask, vColour);
+		}
+		vZ = _mm256_add_ps(vZ, vDzDy);
+		pDepth += fb.iWidth;
+		pColour += fb.iWidth;
+	}
+#else
+	//Same order of operations as the AVX2 lanes, so both paths give identical depths
+	float z[RASTER_BLOCK_SIZE];
+	for (int column = 0; column < RASTER_BLOCK_SIZE; column++)
+		z[column] = fZ + fDzDx * (float)column;
+
+	for (int row = 0; row < nRows; row++) {
+		for (int column = 0; column < nColumns; column++) {
+			int32_t iStepX = column * RASTER_SUBPIXEL_STEP;
+			bool bInside = bFullyCovered || ((e[0] + edges[0].A * iStepX) | (e[1] + edges[1].A * iStepX) | (e[2] + edges[2].A * iStepX)) >= 0;
+			if (bInside && z[column] < pDepth[column]) {
+				pDepth[column] = z[column];
+				pColour[column] = clr;
+			}
+			z[column] += fDzDy;
+		}
+		for (int i = 0; i < 3; i++)
+			e[i] += edges[i].B * RASTER_SUBPIXEL_STEP;
+		pDepth += fb.iWidth;
+		pColour += fb.iWidth;
+	}
+#endif
+}
+
+//Rasterize a screen space triangle of either winding into the frame buffer
+//The triangle is clipped against the screen here, only the near plane has to be clipped beforehand
+void RasterizeTriangle(frameBuffer& fb, rasterVertex v0, rasterVertex v1, rasterVertex v2, uint32_t clr) {
+	//Bounding box of the triangle
+	float fMinX = std::min({ v0.x, v1.x, v2.x });
+	float fMaxX = std::max({ v0.x, v1.x, v2.x });
+	float fMinY = std::min({ v0.y, v1.y, v2.y });
+	float fMaxY = std::max({ v0.y, v1.y, v2.y });
+	if (!(fMaxX >= 0.0f && fMaxY >= 0.0f && fMinX < fb.iWidth && fMinY < fb.iHeight))
+		return; //off screen (or not a number)
+	if (!(fMaxX - fMinX <= FLT_MAX && fMaxY - fMinY <= FLT_MAX))
+		return; //infinite, can not be split
+
+	//Split big triangles at the middle of their longest edge, the depth is linear in screen space
+	if (fMaxX - fMinX > RASTER_MAX_EXTENT || fMaxY - fMinY > RASTER_MAX_EXTENT) {
+		rasterVertex* v[3] = { &v0, &v1, &v2 };
+		auto length = [&](int i) {
+			float dx = v[(i + 1) % 3]->x - v[i]->x;
+			float dy = v[(i + 1) % 3]->y - v[i]->y;
+			return dx * dx + dy * dy;
+		};
+		int i = 0;
+		if (length(1) > length(i)) i = 1;
+		if (length(2) > length(i)) i = 2;
+		rasterVertex a = *v[i], b = *v[(i + 1) % 3], c = *v[(i + 2) % 3];
+		rasterVertex m = { (a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f };
+		RasterizeTriangle(fb, a, m, c, clr);
+		RasterizeTriangle(fb, m, b, c, clr);
+		return;
+	}
+
+	//Pixels of the bounding box that are on the screen, the first block is aligned to the block grid
+	int iMinX = std::max(0, (int)floorf(fMinX)) & ~(RASTER_BLOCK_SIZE - 1);
+	int iMinY = std::max(0, (int)floorf(fMinY)) & ~(RASTER_BLOCK_SIZE - 1);
+	int iMaxX = std::min(fb.iWidth - 1, (int)ceilf(fMaxX));
+	int iMaxY = std::min(fb.iHeight - 1, (int)ceilf(fMaxY));
+
+	//Snap the vertices to the subpixel grid, relative to the first block so the values stay small
+	int32_t X0 = (int32_t)lrintf((v0.x - iMinX) * RASTER_SUBPIXEL_STEP), Y0 = (int32_t)lrintf((v0.y - iMinY) * RASTER_SUBPIXEL_STEP);
+	int32_t X1 = (int32_t)lrintf((v1.x - iMinX) * RASTER_SUBPIXEL_STEP), Y1 = (int32_t)lrintf((v1.y - iMinY) * RASTER_SUBPIXEL_STEP);
+	int32_t X2 = (int32_t)lrintf((v2.x - iMinX) * RASTER_SUBPIXEL_STEP), Y2 = (int32_t)lrintf((v2.y - iMinY) * RASTER_SUBPIXEL_STEP);
+
+	//Twice the signed area, make the winding positive so the inside has E >= 0
+	int64_t iArea = (int64_t)(X1 - X0) * (Y2 - Y0) - (int64_t)(Y1 - Y0) * (X2 - X0);
+	if (iArea == 0)
+		return;
+	if (iArea < 0) {
+		std::swap(X1, X2);
+		std::swap(Y1, Y2);
+		std::swap(v1, v2);
+		iArea = -iArea;
+	}
+
+	rasterEdge edges[3];
+	edges[0] = SetupEdge(X1, Y1, X2, Y2);
+	edges[1] = SetupEdge(X2, Y2, X0, Y0);
+	edges[2] = SetupEdge(X0, Y0, X1, Y1);
+
+	//Depth plane z = z0 + dzdx * (x - x0) + dzdy * (y - y0), in pixels from the first block
+	float fArea = (float)iArea / (RASTER_SUBPIXEL_STEP * RASTER_SUBPIXEL_STEP);
+	float x0 = (float)X0 / RASTER_SUBPIXEL_STEP, y0 = (float)Y0 / RASTER_SUBPIXEL_STEP;
+	float dx1 = (float)(X1 - X0) / RASTER_SUBPIXEL_STEP, dy1 = (float)(Y1 - Y0) / RASTER_SUBPIXEL_STEP;
+	float dx2 = (float)(X2 - X0) / RASTER_SUBPIXEL_STEP, dy2 = (float)(Y2 - Y0) / RASTER_SUBPIXEL_STEP;
+	float fDzDx = ((v1.z - v0.z) * dy2 - (v2.z - v0.z) * dy1) / fArea;
+	float fDzDy = ((v2.z - v0.z) * dx1 - (v1.z - v0.z) * dx2) / fArea;
+	float fZOrigin = v0.z + fDzDx * (0.5f - x0) + fDzDy * (0.5f - y0);
+
+	//Offsets from the first pixel centre of a block to the corner pixel centre where an edge function is
+	//largest (a block is rejected if that is still outside) and smallest (accepted if that is inside)
+	const int32_t iCorner = (RASTER_BLOCK_SIZE - 1) * RASTER_SUBPIXEL_STEP;
+	int32_t iRejectOffset[3], iAcceptOffset[3];
+	for (int i = 0; i < 3; i++) {
+		iRejectOffset[i] = std::max(edges[i].A, 0) * iCorner + std::max(edges[i].B, 0) * iCorner;
+		iAcceptOffset[i] = std::min(edges[i].A, 0) * iCorner + std::min(edges[i].B, 0) * iCorner;
+	}
+
+	int nBlocksX = (iMaxX - iMinX) / RASTER_BLOCK_SIZE + 1;
+	int nBlocksY = (iMaxY - iMinY) / RASTER_BLOCK_SIZE + 1;
+	const int32_t iBlockStep = RASTER_BLOCK_SIZE * RASTER_SUBPIXEL_STEP;
+
+	for (int by = 0; by < nBlocksY; by++) {
+		int y = by * RASTER_BLOCK_SIZE;
+		for (int bx = 0; bx < nBlocksX; bx += 8) {
+			//Classify 8 blocks of the row at once
+			uint32_t iRejected = 0, iAccepted = 0xFF;
+#if defined(__AVX2__)
+			const __m256i vLane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+			__m256i vReject = _mm256_setzero_si256();
+			__m256i vAccept = _mm256_setzero_si256();
+			for (int i = 0; i < 3; i++) {
+				int32_t e = edges[i].iOrigin + edges[i].A * (bx * iBlockStep) + edges[i].B * (by * iBlockStep);
+				__m256i vE = _mm256_add_epi32(_mm256_set1_epi32(e), _mm256_mullo_epi32(_mm256_set1_epi32(edges[i].A * iBlockStep), vLane));
+				vReject = _mm256_or_si256(vReject, _mm256_cmpgt_epi32(_mm256_setzero_si256(), _mm256_add_epi32(vE, _mm256_set1_epi32(iRejectOffset[i]))));
+				vAccept = _mm256_or_si256(vAccept, _mm256_add_epi32(vE, _mm256_set1_epi32(iAcceptOffset[i])));
+			}
+			iRejected = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(vReject));
+			iAccepted = ~(uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(vAccept)) & 0xFF;
+#else
+			for (int lane = 0; lane < 8; lane++) {
+				for (int i = 0; i < 3; i++) {
+					int32_t e = edges[i].iOrigin + edges[i].A * ((bx + lane) * iBlockStep) + edges[i].B * (by * iBlockStep);
+					if (e + iRejectOffset[i] < 0)
+						iRejected |= 1u << lane;
+					if (e + iAcceptOffset[i] < 0)
+						iAccepted &= ~(1u << lane);
+				}
+				if (bx + lane + 1 >= nBlocksX)
+					break;
+			}
+#endif
+			int nLanes = std::min(8, nBlocksX - bx);
+			for (int lane = 0; lane < nLanes; lane++) {
+				if (iRejected & (1u << lane))
+					continue;
+				int x = (bx + lane) * RASTER_BLOCK_SIZE;
+				int32_t e[3];
+				for (int i = 0; i < 3; i++)
+					e[i] = edges[i].iOrigin + edges[i].A * (x * RASTER_SUBPIXEL_STEP) + edges[i].B * (y * RASTER_SUBPIXEL_STEP);
+				float fZ = fZOrigin + fDzDx * x + fDzDy * y;
+				RasterizeBlock(fb, iMinX + x, iMinY + y, edges, e, (iAccepted & (1u << lane)) != 0, fZ, fDzDx, fDzDy, clr);
+			}
+		}
+	}
+}
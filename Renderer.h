@@ -0,0 +1,116 @@
+//Header with the Render Pipeline shared by the interactive window and the batch renderer
+#pragma once
+
+//Transform, light, clip against the near plane and project every triangle of the mesh
+//Returned triangles are in screen space and sorted front to back
+//The mesh is only read, so several threads can project the same mesh at once
+std::vector<triangle> ProjectMesh(const mesh& meshObj, mat4x4& matWorld, mat4x4& matView, mat4x4& matProj, vector3D& vCamera, float fScreenWidth, float fScreenHeight) {
+	//Vector of Triangles
+	//We are using this vector to order the projections
+	std::vector<triangle> vecTrianglesToRaster;
+
+	//Transform and project triangles
+	for (auto tri : meshObj.tris) {
+		triangle triTransformed;
+		triangle triProjected;
+		triangle triViewed;
+
+		triTransformed.p[0] = vectorMatrixProduct(tri.p[0], matWorld);
+		triTransformed.p[1] = vectorMatrixProduct(tri.p[1], matWorld);
+		triTransformed.p[2] = vectorMatrixProduct(tri.p[2], matWorld);
+
+		vector3D normal;
+		vector3D line1;
+		vector3D line2;
+
+		line1 = triTransformed.p[1] - triTransformed.p[0];
+		line2 = triTransformed.p[2] - triTransformed.p[0];
+
+		normal = line1.vCrossProduct(line2);
+		normal = normal.vNormalise();
+
+		vector3D vCameraRay = triTransformed.p[0] - vCamera;
+
+		if (normal.vDotProduct(vCameraRay) < 0.0f) {
+			//lighting
+			vector3D light_direction = { 0.0f, 0.5f, -1.0f };
+			light_direction = light_direction.vNormalise();
+
+			// How similar is normal to light direction
+			float dp = std::max(0.1f, light_direction.vDotProduct(normal));
+
+			//Initialize colors of the model and change the intenisty based on lighting info
+			int iRcomp = 150;
+			int iGcomp = 0;
+			int iBcomp = 150;
+			triViewed.clr.r = (sf::Uint8)(iRcomp * dp);
+			triViewed.clr.g = (sf::Uint8)(iGcomp * dp);
+			triViewed.clr.b = (sf::Uint8)(iBcomp * dp);
+			//Colors cannot be over 255
+			if (iRcomp * dp > 255)
+				triViewed.clr.r = 255;
+			if (iGcomp * dp > 255)
+				triViewed.clr.g = 255;
+			if (iBcomp * dp > 255)
+				triViewed.clr.b = 255;
+			triViewed.clr.a = tri.clr.a;
+
+			triViewed.p[0] = vectorMatrixProduct(triTransformed.p[0], matView);
+			triViewed.p[1] = vectorMatrixProduct(triTransformed.p[1], matView);
+			triViewed.p[2] = vectorMatrixProduct(triTransformed.p[2], matView);
+
+
+			//Clip Triangles against the Screen of the Camera
+			int nClippedTriangles = 0;
+			triangle clipped[2];
+			nClippedTriangles = Triangle_ClipAgainstPlane({ 0.0f, 0.0f, 0.1f }, { 0.0f, 0.0f, 1.0f }, triViewed, clipped[0], clipped[1]);
+
+			for (int n = 0; n < nClippedTriangles; n++) {
+
+				//Project from 3D -> 2D
+				triProjected.p[0] = vectorMatrixProduct(clipped[n].p[0], matProj);
+				triProjected.p[1] = vectorMatrixProduct(clipped[n].p[1], matProj);
+				triProjected.p[2] = vectorMatrixProduct(clipped[n].p[2], matProj);
+				triProjected.clr = clipped[n].clr;
+
+				triProjected.p[0] = triProjected.p[0] / triProjected.p[0].w;
+				triProjected.p[1] = triProjected.p[1] / triProjected.p[1].w;
+				triProjected.p[2] = triProjected.p[2] / triProjected.p[2].w;
+
+				vector3D vOffsetView = { 1.0f, 1.0f, 0.0f };
+
+				triProjected.p[0] = triProjected.p[0] + vOffsetView;
+				triProjected.p[1] = triProjected.p[1] + vOffsetView;
+				triProjected.p[2] = triProjected.p[2] + vOffsetView;
+				triProjected.p[0].x *= 0.5f * fScreenWidth;
+				triProjected.p[0].y *= 0.5f * fScreenHeight;
+				triProjected.p[1].x *= 0.5f * fScreenWidth;
+				triProjected.p[1].y *= 0.5f * fScreenHeight;
+				triProjected.p[2].x *= 0.5f * fScreenWidth;
+				triProjected.p[2].y *= 0.5f * fScreenHeight;
+
+				vecTrianglesToRaster.push_back(triProjected);
+			}
+		}
+	}
+
+	//Sort Based on which triangle is closer to the screen
+	//Closest first, so hidden pixels fail the depth test instead of being drawn over
+	sort(vecTrianglesToRaster.begin(), vecTrianglesToRaster.end(), [](triangle& t1, triangle& t2) {
+		float z1 = (t1.p[0].z + t1.p[1].z + t1.p[2].z) / 3.0f;
+		float z2 = (t2.p[0].z + t2.p[1].z + t2.p[2].z) / 3.0f;
+		return z1 < z2;
+		});
+
+	return vecTrianglesToRaster;
+}
+
+//Rasterize projected Triangles into the frame buffer, the rasterizer clips them against the screen
+void DrawTriangles(frameBuffer& fb, std::vector<triangle>& vecTrianglesToRaster) {
+	for (auto& t : vecTrianglesToRaster) {
+		rasterVertex v0 = { t.p[0].x, t.p[0].y, t.p[0].z };
+		rasterVertex v1 = { t.p[1].x, t.p[1].y, t.p[1].z };
+		rasterVertex v2 = { t.p[2].x, t.p[2].y, t.p[2].z };
+		RasterizeTriangle(fb, v0, v1, v2, PackColour(t.clr.r, t.clr.g, t.clr.b, 255));
+	}
+}